@@ -4,31 +4,64 @@
 #include "device_id.h"
 #include "object_id.h"
 #include "event.h"
+#include "interaction_history.h"
+#include "mobility_predictor.h"
 #include <unordered_map> // Use unordered_map to store <ObjectID, Timestamp> for LRU
-#include <unordered_set> // To store interacted objects
 #include <queue>
 #include <functional>
+#include <vector>
 
 using Location = std::pair<double, double>;
 
+// Running summary of a latency distribution
+struct LatencyStats {
+    int count = 0;
+    double total = 0.0;
+    double max = 0.0;
+    void add(double value) {
+        ++count;
+        total += value;
+        if (value > max) max = value;
+    }
+    void merge(const LatencyStats& other) {
+        count += other.count;
+        total += other.total;
+        if (other.max > max) max = other.max;
+    }
+    double mean() const { return count ? total / count : 0.0; }
+};
+
 class ARDevice {
 public:
     DeviceID deviceId;
     int localCacheSizeLimit; // Maximum size of the local cache
     int currentLocalCacheSize;
     std::unordered_map<ObjectID, Timestamp> localCache; // Store <ObjectID, LastAccessTime> for LRU
+    std::unordered_map<ObjectID, int> localCacheLevels; // Levels of detail held for each cached object
     std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>* eventQueue;
     Timestamp currentTime; // To track the current simulation time for LRU updates
-    std::unordered_set<ObjectID> interactedObjects; // Keep track of interacted objects
+    InteractionHistory interactedObjects; // Recently interacted objects (bounded)
     Location location; // ARDevice location
+    MobilityPredictor mobility; // Recent movement, used to predict where the device is heading
+
+    // Perceived latency of object views, measured from the request
+    LatencyStats timeToFirstRender; // Until the coarsest level of detail is available
+    LatencyStats timeToFullQuality; // Until every level of detail is available
+    long long bytesReceived = 0;
 
     ARDevice(DeviceID id, int cacheLimit, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>* queue, Location initialLocation);
     void requestObject(Timestamp time, ObjectID objectId);
-    void receiveObject(Timestamp time, ObjectID objectId);
+    void receiveObject(Timestamp time, ObjectID objectId, int lodLevel = 0);
     void move(Timestamp time, Location newLocation); // Function to move the ARDevice
 private:
-    void evictLRUObject();
-    int getObjectSize(ObjectID objectId);
+    struct PendingView {
+        Timestamp requestTime;
+        bool rendered; // Coarsest level already shown
+    };
+    std::unordered_map<ObjectID, std::vector<PendingView>> pendingViews; // Views still waiting for full quality, in request order
+
+    bool evictLRUObject(ObjectID protectedObjectId); // Skips the protected object and objects still streaming to a view; returns false if nothing else is cached
+    int getCachedLevels(ObjectID objectId);
 };
 
 #endif // AR_DEVICE_H
\ No newline at end of file
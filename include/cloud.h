@@ -10,7 +10,12 @@
 
 class Cloud {
 public:
-    void processRequest(Timestamp time, ObjectID objectId, ServerID serverId, DeviceID deviceId, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue);
+    double latency = 2.0; // Example latency
+    double bandwidth = 0.0; // Size units per time unit on the cloud-to-edge link, 0 ignores transfer time
+
+    // Sends levels of detail startLevel.. of the object back to the edge, coarsest first.
+    // deviceStartLevel is passed through so the edge knows which levels the device still needs.
+    void processRequest(Timestamp time, ObjectID objectId, ServerID serverId, DeviceID deviceId, int startLevel, int deviceStartLevel, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue);
 };
 
 #endif // CLOUD_H
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "device_id.h"
 #include "event.h"
 #include "ar_device.h"
+#include "frequency_sketch.h"
+#include "simulation_profiler.h"
+#include "spatial_index.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
@@ -21,14 +24,30 @@ struct ObjectInfo {
     Location location;
 };
 
+struct PrefetchCandidate {
+    ObjectID id;
+    double score; // Rule confidence plus trajectory score
+    double trajectoryScore; // Prediction confidence weighted by proximity to the predicted position
+};
+
 class EdgeServer {
 public:
     ServerID serverId;
     int edgeCacheSizeLimit; // Maximum size of the edge cache
     int currentEdgeCacheSize;
     std::unordered_map<ObjectID, Timestamp> edgeCache; // Store <ObjectID, LastAccessTime> for LRU
+    std::unordered_map<ObjectID, int> edgeCacheLevels; // Levels of detail held for each cached object
+    double deviceBandwidth = 0.0; // Size units per time unit on the edge-to-device link, 0 ignores transfer time
+    std::unordered_map<DeviceID, Timestamp> deviceLinkFreeAt; // When each device's link finishes its queued transfers
     std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>* eventQueue;
     Timestamp currentTime; // To track current simulation time for LRU updates
+    double fovRadius = 10.0; // Example FoV radius used to filter prefetch candidates
+    double predictionHorizon = 0.0; // How far ahead to extrapolate device movement for prefetching, 0 disables it
+    double minPredictionConfidence = 0.2; // Predictions less certain than this are ignored
+    int prefetchCandidateLimit = 2; // Highest-scoring candidates prefetched per decision
+    double minPrefetchScore = 0.1; // Candidates scoring below this are not prefetched
+    std::unordered_map<ObjectID, double> pendingPrefetches; // Prefetches in flight -> their trajectory score
+    SpatialIndex objectIndex; // Object locations bucketed by FoV-sized cells
 
     std::vector<ObjectInfo> tempMetadata;
 
@@ -37,20 +56,46 @@ public:
     std::string associationRuleFile;
 
     std::map<DeviceID, ARDevice*> *simulationDevices;
+    SimulationProfiler* profiler = nullptr; // Set by SimulationEngine::addServer
+
+    // Optional TinyLFU-style admission filter (disabled by default)
+    bool admissionFilterEnabled = false;
+    FrequencySketch frequencySketch;
+    int prefetchAdmissionThreshold = 2; // Minimum estimated frequency for a prefetched object to be admitted
+    // A predicted object has no request history yet, so request counts cannot judge it. A trajectory prefetch
+    // scoring at least this is admitted on the prediction alone; weaker ones face the frequency checks above.
+    double trajectoryAdmissionScore = 0.3;
 
     EdgeServer(ServerID id, 
         int cacheLimit, 
         std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>* queue, 
         const std::string& ruleFile = "association_rule.txt");
     bool loadAssociationRules(); // Function to load rules from the file
-    void handleDeviceRequest(Timestamp time, ObjectID objectId, DeviceID deviceId);
-    void handleCloudResponse(Timestamp time, ObjectID objectId, DeviceID deviceId);
+    void indexObjectLocations(); // Rebuild objectIndex after objectLocations or fovRadius change
+    void handleDeviceRequest(Timestamp time, ObjectID objectId, DeviceID deviceId, int startLevel = 0);
+    void handleCloudResponse(Timestamp time, ObjectID objectId, DeviceID deviceId, int lodLevel = 0, int deviceStartLevel = 0);
+    void handleDeviceMove(Timestamp time, DeviceID deviceId); // Trajectory-predictive prefetching
     void triggerPrefetching(Timestamp time); // Placeholder for prefetching logic
+    void enableAdmissionFilter(int expectedObjects, int prefetchThreshold = 2);
 private:
-    void evictLRUObject();
-    int getObjectSize(ObjectID objectId);
+    ObjectID selectEvictionVictim(const std::unordered_set<ObjectID>& excludedIds); // Returns -1 if every cached object is excluded
+    void evictObject(ObjectID objectId);
+    bool makeRoomFor(ObjectID objectId, int objectSize, bool isPrefetch, bool confidentPrediction = false); // Evict other objects until it fits, subject to admission
+    bool selectVictimsFor(ObjectID objectId, int objectSize, bool isPrefetch, bool confidentPrediction, std::vector<ObjectID>& victims); // Decide admission without evicting
+    int getCachedLevels(ObjectID objectId);
+    Timestamp deviceTransferTime(ObjectID objectId, int lodLevel);
+    Timestamp scheduleDeviceDelivery(Timestamp time, DeviceID deviceId, ObjectID objectId, int lodLevel); // Queue a level on the device's link, returns its arrival time
     bool canCacheObject(ObjectID objectId);
-    std::vector<ObjectID> getPrefetchCandidates(const std::unordered_set<ObjectID>& interactedObjects);
+    std::vector<PrefetchCandidate> getPrefetchCandidates(ARDevice* requestingDevice, bool useRules = true);
+    void prefetchObjects(Timestamp time, const std::vector<PrefetchCandidate>& candidates, const char* reason);
+
+    // Rules parsed once at load time; antecedents sorted for subset matching
+    struct ParsedRule {
+        std::vector<ObjectID> antecedent;
+        std::vector<std::pair<ObjectID, double>> consequents; // <Consequent, Confidence>
+    };
+    std::vector<ParsedRule> parsedRules;
+    std::vector<ObjectID> nearbyObjects; // Reused across spatial queries
 };
 
 // Utility function to calculate distance between two locations
@@ -4,6 +4,7 @@
 #include "object_id.h"
 #include "device_id.h"
 #include "server_id.h"
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <queue>
@@ -17,18 +18,24 @@ using Timestamp = double;
 
 struct Event {
     Timestamp timestamp;
+    uint64_t sequence; // Creation order, breaks timestamp ties so simultaneous events run first-in first-out
     Event(Timestamp time);
     virtual void process(std::map<DeviceID, ARDevice*>& devices,
                          std::map<ServerID, EdgeServer*>& servers,
                          Cloud& cloud,
                          std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) = 0;
     virtual ~Event() {}
+private:
+    static uint64_t nextSequence;
 };
 
 // Custom comparator for the priority queue
 struct CompareEvents {
     bool operator()(Event* a, Event* b) {
-        return a->timestamp > b->timestamp;
+        if (a->timestamp != b->timestamp) {
+            return a->timestamp > b->timestamp;
+        }
+        return a->sequence > b->sequence;
     }
 };
 
@@ -46,7 +53,8 @@ struct UserSeesObjectEvent : public Event {
 struct EdgeRequestEvent : public Event {
     DeviceID deviceId;
     ObjectID objectId;
-    EdgeRequestEvent(Timestamp time, DeviceID dId, ObjectID oId);
+    int startLevel; // First level of detail the device still needs
+    EdgeRequestEvent(Timestamp time, DeviceID dId, ObjectID oId, int startLod = 0);
     void process(std::map<DeviceID, ARDevice*>& devices,
                  std::map<ServerID, EdgeServer*>& servers,
                  Cloud& cloud,
@@ -57,7 +65,9 @@ struct CloudRequestEvent : public Event {
     ServerID serverId;
     ObjectID objectId;
     DeviceID requestingDeviceId;
-    CloudRequestEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId);
+    int startLevel; // First level of detail to send
+    int deviceStartLevel; // First level of detail the edge forwards to the device
+    CloudRequestEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId, int startLod = 0, int deviceStartLod = 0);
     void process(std::map<DeviceID, ARDevice*>& devices,
                  std::map<ServerID, EdgeServer*>& servers,
                  Cloud& cloud,
@@ -67,7 +77,8 @@ struct CloudRequestEvent : public Event {
 struct DeviceResponseEvent : public Event {
     DeviceID deviceId;
     ObjectID objectId;
-    DeviceResponseEvent(Timestamp time, DeviceID dId, ObjectID oId);
+    int lodLevel;
+    DeviceResponseEvent(Timestamp time, DeviceID dId, ObjectID oId, int lod = 0);
     void process(std::map<DeviceID, ARDevice*>& devices,
                  std::map<ServerID, EdgeServer*>& servers,
                  Cloud& cloud,
@@ -78,7 +89,9 @@ struct EdgeResponseEvent : public Event {
     ServerID serverId;
     ObjectID objectId;
     DeviceID targetDeviceId;
-    EdgeResponseEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId);
+    int lodLevel;
+    int deviceStartLevel; // Levels below this are only cached at the edge, the device already has them
+    EdgeResponseEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId, int lod = 0, int deviceStartLod = 0);
     void process(std::map<DeviceID, ARDevice*>& devices,
                  std::map<ServerID, EdgeServer*>& servers,
                  Cloud& cloud,
@@ -92,11 +105,7 @@ struct ARDeviceMoveEvent : public Event {
     void process(std::map<DeviceID, ARDevice*>& devices,
                  std::map<ServerID, EdgeServer*>& servers,
                  Cloud& cloud,
-                 std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) override {
-        if (devices.count(deviceId)) {
-            devices[deviceId]->move(timestamp, newLocation);
-        }
-    }
+                 std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) override;
 };
 
 #endif // EVENT_H
\ No newline at end of file
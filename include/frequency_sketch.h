@@ -0,0 +1,33 @@
+#ifndef FREQUENCY_SKETCH_H
+#define FREQUENCY_SKETCH_H
+
+#include "object_id.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Count-min sketch with 4-bit counters, used to estimate how often an object
+// has been requested recently (TinyLFU). All counters are halved once the
+// number of recorded accesses reaches the sample size, so old popularity fades.
+class FrequencySketch {
+public:
+    explicit FrequencySketch(int expectedObjects = 0);
+    void resize(int expectedObjects); // Re-allocate for a new catalog size and clear all counts
+    void increment(ObjectID objectId); // Record one access
+    int estimate(ObjectID objectId) const; // Estimated recent access count (0 - 15)
+    size_t memoryBytes() const;
+    int samplePeriod() const { return sampleSize; } // Accesses between two agings
+private:
+    static const int kDepth = 4; // Number of hash rows
+    static const int kMaxCount = 15; // Saturation value of a 4-bit counter
+
+    std::vector<uint64_t> table; // 16 counters packed per word, rows stored back to back
+    uint64_t rowWidth; // Counters per row (power of two)
+    int sampleSize; // Accesses recorded before the counters are aged
+    int additions;
+
+    uint64_t counterIndex(ObjectID objectId, int row) const;
+    void age();
+};
+
+#endif // FREQUENCY_SKETCH_H
@@ -0,0 +1,40 @@
+#ifndef INTERACTION_HISTORY_H
+#define INTERACTION_HISTORY_H
+
+#include "object_id.h"
+#include "event.h"
+#include <cstddef>
+#include <vector>
+
+// Bounded record of the objects a device interacted with recently. Holds at most
+// `capacity` distinct objects; entries older than `window` are dropped, and when
+// full the least recently seen object is replaced. Storage is allocated once, so
+// per-device memory stays flat regardless of session length.
+class InteractionHistory {
+public:
+    static const int kDefaultCapacity = 16;
+    static constexpr Timestamp kDefaultWindow = 60.0; // 0 keeps entries until displaced
+
+    using const_iterator = std::vector<ObjectID>::const_iterator;
+
+    explicit InteractionHistory(int capacity = kDefaultCapacity, Timestamp window = kDefaultWindow);
+    void record(Timestamp time, ObjectID objectId);
+    void expire(Timestamp time); // Drop entries not seen within the window
+    bool contains(ObjectID objectId) const;
+    size_t size() const { return objectIds.size(); }
+    bool empty() const { return objectIds.empty(); }
+
+    // Iterates object IDs in ascending order without allocating
+    const_iterator begin() const { return objectIds.begin(); }
+    const_iterator end() const { return objectIds.end(); }
+
+private:
+    std::vector<ObjectID> objectIds; // Sorted ascending
+    std::vector<Timestamp> lastSeen; // Parallel to objectIds
+    int capacity;
+    Timestamp window;
+
+    void eraseAt(size_t index);
+};
+
+#endif // INTERACTION_HISTORY_H
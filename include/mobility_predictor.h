@@ -0,0 +1,42 @@
+#ifndef MOBILITY_PREDICTOR_H
+#define MOBILITY_PREDICTOR_H
+
+#include "event.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+using Location = std::pair<double, double>;
+
+// Extrapolates a device's position from its recent movement samples with a
+// constant-velocity least-squares fit. Keeps a fixed number of samples.
+class MobilityPredictor {
+public:
+    static const int kDefaultHistory = 8;
+    static constexpr int kMinSamples = 3; // Two points always fit a line, so a trend needs a third
+
+    struct Prediction {
+        Location location;
+        double confidence; // 0 (no idea) to 1 (certain to be within tolerance of location)
+    };
+
+    Timestamp maxExtrapolation = 5.0; // Predictions never extrapolate further past the newest sample
+    double velocityNoise = 0.5; // Assumed drift of the true velocity from the fit, in distance units per time unit
+
+    explicit MobilityPredictor(int historySize = kDefaultHistory);
+    void addSample(Timestamp time, Location location);
+    // Predicted position at `time`; confidence reflects how well the samples fit a straight
+    // path and how far ahead we extrapolate, relative to `tolerance` distance units
+    Prediction predict(Timestamp time, double tolerance) const;
+    size_t sampleCount() const { return times.size(); }
+
+private:
+    std::vector<Timestamp> times; // Ring buffer, oldest sample at `next` once full
+    std::vector<Location> locations;
+    int historySize;
+    size_t next = 0;
+
+    size_t newestIndex() const;
+};
+
+#endif // MOBILITY_PREDICTOR_H
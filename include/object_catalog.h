@@ -0,0 +1,36 @@
+#ifndef OBJECT_CATALOG_H
+#define OBJECT_CATALOG_H
+
+#include "object_id.h"
+#include <map>
+#include <vector>
+
+// Defined in main.cpp
+extern std::map<ObjectID, int> objectSizes; // Size of the full-quality object when delivered in one piece
+extern std::map<ObjectID, std::vector<int>> objectLODSizes; // Incremental size of each level of detail, coarsest first
+
+// Objects without LOD variants are delivered as a single level of objectSizes[id]
+inline int getLODCount(ObjectID objectId) {
+    auto it = objectLODSizes.find(objectId);
+    return it != objectLODSizes.end() && !it->second.empty() ? static_cast<int>(it->second.size()) : 1;
+}
+
+inline int getLODSize(ObjectID objectId, int level) {
+    auto it = objectLODSizes.find(objectId);
+    if (it != objectLODSizes.end() && level >= 0 && level < static_cast<int>(it->second.size())) {
+        return it->second[level];
+    }
+    auto sizeIt = objectSizes.find(objectId);
+    return level == 0 && sizeIt != objectSizes.end() ? sizeIt->second : 0;
+}
+
+// Total size of the first `levels` levels of detail
+inline int getLODBytes(ObjectID objectId, int levels) {
+    int bytes = 0;
+    for (int level = 0; level < levels; ++level) {
+        bytes += getLODSize(objectId, level);
+    }
+    return bytes;
+}
+
+#endif // OBJECT_CATALOG_H
@@ -5,10 +5,12 @@
 #include "ar_device.h"
 #include "edge_server.h"
 #include "cloud.h"
+#include "simulation_profiler.h"
 #include <map>
 #include <queue>
 #include <vector>
 #include <functional>
+#include <ostream>
 
 class SimulationEngine {
 public:
@@ -17,12 +19,14 @@ public:
     std::map<ServerID, EdgeServer*> servers;
     Cloud cloud;
     Timestamp currentTime = 0.0;
+    SimulationProfiler profiler; // Disabled unless profiler.enable() is called
 
     SimulationEngine(); // Add a constructor to initialize the priority queue with the comparator
     void addDevice(ARDevice* device);
     void addServer(EdgeServer* server);
     void addEvent(Event* event);
     void run();
+    void reportDeliveryMetrics(std::ostream& out) const; // Perceived latency and bytes delivered across all devices
 };
 
 #endif // SIMULATION_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef SIMULATION_PROFILER_H
+#define SIMULATION_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Wall-clock timing statistics with a log2 histogram of nanosecond durations
+struct TimingStats {
+    static const int kHistogramBuckets = 40; // Bucket i holds durations in [2^(i-1), 2^i) ns
+    uint64_t count = 0;
+    uint64_t totalNanos = 0;
+    uint64_t maxNanos = 0;
+    std::array<uint64_t, kHistogramBuckets> histogram{};
+
+    void add(uint64_t nanos);
+    uint64_t percentileNanos(double fraction) const; // Upper bound of the bucket holding the given fraction
+};
+
+// Self-profiling for the simulation loop. Everything is a no-op until enable() is called,
+// so the disabled cost is a single branch per event.
+class SimulationProfiler {
+public:
+    bool enabled = false;
+
+    void enable(bool hardwareCounters = false); // Hardware counters use perf_event_open (Linux only)
+    void beginRun();
+    void endRun();
+    void recordEvent(const std::type_index& eventType, uint64_t nanos, size_t queueDepth);
+    void recordSection(const char* name, uint64_t nanos);
+    void report(std::ostream& out) const;
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static const int kHardwareCounters = 4;
+    static const uint64_t kThroughputSampleNanos = 100000000; // Sample events/sec every 100 ms
+
+    std::unordered_map<std::type_index, TimingStats> eventStats;
+    std::map<std::string, TimingStats, std::less<>> sectionStats;
+    size_t maxQueueDepth = 0;
+    uint64_t eventsProcessed = 0;
+    uint64_t runStartNanos = 0;
+    uint64_t runEndNanos = 0;
+    uint64_t lastSampleNanos = 0;
+    uint64_t lastSampleEvents = 0;
+    std::vector<std::pair<double, double>> throughputSamples; // <Seconds since start, Events/sec>
+
+    bool hardwareCountersRequested = false;
+    std::array<int, kHardwareCounters> perfFds{{-1, -1, -1, -1}};
+    std::array<uint64_t, kHardwareCounters> hardwareCounts{};
+
+    void openHardwareCounters();
+    void closeHardwareCounters();
+};
+
+// Times the enclosing scope as a named section when profiling is enabled
+class ProfileScope {
+public:
+    ProfileScope(SimulationProfiler* profiler, const char* name)
+        : profiler(profiler && profiler->enabled ? profiler : nullptr), name(name),
+          start(this->profiler ? SimulationProfiler::now() : 0) {}
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->recordSection(name, SimulationProfiler::now() - start);
+        }
+    }
+private:
+    SimulationProfiler* profiler;
+    const char* name;
+    uint64_t start;
+};
+
+#endif // SIMULATION_PROFILER_H
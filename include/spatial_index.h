@@ -0,0 +1,38 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "object_id.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using Location = std::pair<double, double>;
+
+// Uniform grid over object locations. A radius query only visits the cells
+// overlapping the query square, so its cost follows local density rather than
+// catalog size. Cells about as large as the query radius work best.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(double cellSize = 10.0);
+    void clear();
+    void insert(ObjectID objectId, Location location);
+    // Replaces `result` with the objects within `radius` of `center`, in no particular order
+    void queryRadius(Location center, double radius, std::vector<ObjectID>& result) const;
+    size_t size() const { return objectCount; }
+
+private:
+    struct Entry {
+        ObjectID id;
+        Location location;
+    };
+    std::unordered_map<uint64_t, std::vector<Entry>> cells; // Packed cell coordinates -> objects in the cell
+    double cellSize;
+    size_t objectCount = 0;
+
+    int64_t cellCoordinate(double value) const;
+    static uint64_t cellKey(int64_t cellX, int64_t cellY);
+};
+
+#endif // SPATIAL_INDEX_H
@@ -1,48 +1,94 @@
 #include "ar_device.h"
 #include "event.h"
+#include "object_catalog.h"
 #include <iostream>
 #include <algorithm>
-
-// Assuming objectSizes is defined globally or passed appropriately
-extern std::map<ObjectID, int> objectSizes;
+#include <limits>
 
 ARDevice::ARDevice(DeviceID id, int cacheLimit, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>* queue, Location initialLocation)
-    : deviceId(id), localCacheSizeLimit(cacheLimit), currentLocalCacheSize(0), eventQueue(queue), currentTime(0.0), location(initialLocation){}
+    : deviceId(id), localCacheSizeLimit(cacheLimit), currentLocalCacheSize(0), eventQueue(queue), currentTime(0.0), location(initialLocation) {}
 
     void ARDevice::requestObject(Timestamp time, ObjectID objectId) {
         currentTime = time;
         std::cout << time << ": Device " << deviceId << " requests object " << objectId << " at (" << location.first << ", " << location.second << ")" << std::endl;
-        interactedObjects.insert(objectId);
-        if (localCache.find(objectId) == localCache.end()) {
+        interactedObjects.record(time, objectId);
+        int cachedLevels = getCachedLevels(objectId);
+        if (cachedLevels == 0) {
+            pendingViews[objectId].push_back({time, false});
             eventQueue->push(new EdgeRequestEvent(time, deviceId, objectId));
+        } else if (cachedLevels < getLODCount(objectId)) {
+            // Render the cached coarse levels now and fetch the refinements
+            std::cout << time << ": Device " << deviceId << " found " << cachedLevels << " level(s) of detail of object " << objectId << " in local cache." << std::endl;
+            localCache[objectId] = time;
+            timeToFirstRender.add(0.0);
+            pendingViews[objectId].push_back({time, true});
+            eventQueue->push(new EdgeRequestEvent(time, deviceId, objectId, cachedLevels));
         } else {
             std::cout << time << ": Device " << deviceId << " found object " << objectId << " in local cache." << std::endl;
             localCache[objectId] = time;
+            timeToFirstRender.add(0.0);
+            timeToFullQuality.add(0.0);
         }
     }
 
-void ARDevice::receiveObject(Timestamp time, ObjectID objectId) {
+void ARDevice::receiveObject(Timestamp time, ObjectID objectId, int lodLevel) {
     currentTime = time;
-    int objectSize = getObjectSize(objectId);
+    int levelSize = getLODSize(objectId, lodLevel);
+    bytesReceived += levelSize;
+
+    int cachedLevels = getCachedLevels(objectId);
+    // A refinement is useless once the levels below it are gone; objects too large to cache are shown as they stream
+    bool prefixMissing = lodLevel > cachedLevels && getLODBytes(objectId, lodLevel + 1) <= localCacheSizeLimit;
+
+    // Every outstanding view of this object benefits from the level, including repeat views
+    auto pending = pendingViews.find(objectId);
+    if (pending != pendingViews.end()) {
+        bool lastLevel = lodLevel == getLODCount(objectId) - 1;
+        for (PendingView& view : pending->second) {
+            if (prefixMissing) {
+                break; // The device cannot show this level, so the views never reach full quality
+            }
+            if (!view.rendered) {
+                timeToFirstRender.add(time - view.requestTime);
+                view.rendered = true;
+            }
+            if (lastLevel) {
+                timeToFullQuality.add(time - view.requestTime);
+            }
+        }
+        if (lastLevel) {
+            pendingViews.erase(pending);
+        }
+    }
+
+    if (lodLevel < cachedLevels) {
+        // Level already in cache, update last access time
+        localCache[objectId] = time;
+        std::cout << time << ": Device " << deviceId << " re-received object " << objectId << " (level " << lodLevel << "). Updated access time." << std::endl;
+        return;
+    }
+    if (lodLevel > cachedLevels) {
+        // A refinement is only useful on top of the levels below it
+        std::cout << time << ": Device " << deviceId << " cannot cache level " << lodLevel << " of object " << objectId << " without level " << cachedLevels << "." << std::endl;
+        return;
+    }
+
+    int objectSize = getLODBytes(objectId, lodLevel + 1);
     if (objectSize > localCacheSizeLimit) {
         std::cout << time << ": Device " << deviceId << " cannot cache object " << objectId << " (size " << objectSize << " exceeds limit " << localCacheSizeLimit << ")." << std::endl;
         return;
     }
 
-    if (localCache.find(objectId) == localCache.end()) {
-        // Object not in cache, add it
-        while (currentLocalCacheSize + objectSize > localCacheSizeLimit && !localCache.empty()) {
-            evictLRUObject();
-        }
-        if (currentLocalCacheSize + objectSize <= localCacheSizeLimit) {
-            localCache[objectId] = time;
-            currentLocalCacheSize += objectSize;
-            std::cout << time << ": Device " << deviceId << " received and cached object " << objectId << " (size " << objectSize << "). Current cache size: " << currentLocalCacheSize << std::endl;
-        }
-    } else {
-        // Object already in cache, update last access time
+    while (currentLocalCacheSize + levelSize > localCacheSizeLimit) {
+        if (!evictLRUObject(objectId)) break;
+    }
+    if (currentLocalCacheSize + levelSize <= localCacheSizeLimit) {
         localCache[objectId] = time;
-        std::cout << time << ": Device " << deviceId << " re-received object " << objectId << ". Updated access time." << std::endl;
+        localCacheLevels[objectId] = lodLevel + 1;
+        currentLocalCacheSize += levelSize;
+        std::cout << time << ": Device " << deviceId << " received and cached object " << objectId << " level " << lodLevel << " (size " << levelSize << "). Current cache size: " << currentLocalCacheSize << std::endl;
+    } else {
+        std::cout << time << ": Device " << deviceId << " received object " << objectId << " level " << lodLevel << ", but no space to cache." << std::endl;
     }
 }
 
@@ -50,32 +96,36 @@ void ARDevice::move(Timestamp time, Location newLocation) {
     currentTime = time;
     std::cout << time << ": Device " << deviceId << " moved from (" << location.first << ", " << location.second << ") to (" << newLocation.first << ", " << newLocation.second << ")" << std::endl;
     location = newLocation;
+    mobility.addSample(time, newLocation);
+    interactedObjects.expire(time); // Otherwise stale interactions linger until the next request
     // You might want to trigger a prefetching update or cache invalidation here
     // based on the new location. For simplicity, we'll leave that for later.
 }
 
-void ARDevice::evictLRUObject() {
-    if (localCache.empty()) return;
-
-    ObjectID lruObjectId;
-    Timestamp minTime = currentTime; // Initialize with a future time to ensure the first element is smaller
+bool ARDevice::evictLRUObject(ObjectID protectedObjectId) {
+    bool found = false;
+    ObjectID lruObjectId = 0;
+    Timestamp minTime = std::numeric_limits<Timestamp>::max();
 
     for (const auto& pair : localCache) {
+        if (pair.first == protectedObjectId || pendingViews.count(pair.first)) continue; // Still streaming to a view
         if (pair.second < minTime) {
             minTime = pair.second;
             lruObjectId = pair.first;
+            found = true;
         }
     }
+    if (!found) return false;
 
-    int evictedSize = getObjectSize(lruObjectId);
+    int evictedSize = getLODBytes(lruObjectId, getCachedLevels(lruObjectId));
     localCache.erase(lruObjectId);
+    localCacheLevels.erase(lruObjectId);
     currentLocalCacheSize -= evictedSize;
     std::cout << currentTime << ": Device " << deviceId << " evicted object " << lruObjectId << " (size " << evictedSize << ") due to cache full. New cache size: " << currentLocalCacheSize << std::endl;
+    return true;
 }
 
-int ARDevice::getObjectSize(ObjectID objectId) {
-    if (objectSizes.count(objectId)) {
-        return objectSizes[objectId];
-    }
-    return 0; // Default size if not found
+int ARDevice::getCachedLevels(ObjectID objectId) {
+    auto it = localCacheLevels.find(objectId);
+    return it != localCacheLevels.end() ? it->second : 0;
 }
\ No newline at end of file
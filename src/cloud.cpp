@@ -1,9 +1,15 @@
 #include "cloud.h"
 #include "event.h"
+#include "object_catalog.h"
 #include <iostream>
 
-void Cloud::processRequest(Timestamp time, ObjectID objectId, ServerID serverId, DeviceID deviceId, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
-    double cloudLatency = 2.0; // Example latency
+void Cloud::processRequest(Timestamp time, ObjectID objectId, ServerID serverId, DeviceID deviceId, int startLevel, int deviceStartLevel, std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
     std::cout << time << ": Cloud received request for object " << objectId << " from edge " << serverId << " (for device " << deviceId << "). Processing..." << std::endl;
-    eventQueue.push(new EdgeResponseEvent(time + cloudLatency, serverId, objectId, deviceId));
+    Timestamp arrival = time + latency;
+    for (int level = startLevel; level < getLODCount(objectId); ++level) {
+        if (bandwidth > 0.0) {
+            arrival += getLODSize(objectId, level) / bandwidth; // Levels are streamed back to back
+        }
+        eventQueue.push(new EdgeResponseEvent(arrival, serverId, objectId, deviceId, level, deviceStartLevel));
+    }
 }
\ No newline at end of file
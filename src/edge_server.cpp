@@ -1,13 +1,14 @@
 #include "edge_server.h"
 #include "event.h"
+#include "object_catalog.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <iomanip>
-
-// Assuming objectSizes is defined globally
-extern std::map<ObjectID, int> objectSizes;
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 // Assuming objectSizes is defined globally or passed appropriately
 extern std::map<ObjectID, Location> objectLocations;
@@ -18,6 +19,7 @@ EdgeServer::EdgeServer(ServerID id,
     const std::string& ruleFile)
     : serverId(id), edgeCacheSizeLimit(cacheLimit), currentEdgeCacheSize(0), eventQueue(queue), currentTime(0.0), associationRuleFile(ruleFile) {
         loadAssociationRules();
+        indexObjectLocations();
     }
 
 bool EdgeServer::loadAssociationRules() {
@@ -47,37 +49,81 @@ bool EdgeServer::loadAssociationRules() {
         }
     }
     file.close();
+
+    parsedRules.clear();
+    for (const auto& rulePair : associationRules) {
+        ParsedRule rule;
+        std::stringstream ss(rulePair.first);
+        std::string segment;
+        while (ss >> segment) {
+            rule.antecedent.push_back(std::stoi(segment));
+        }
+        std::sort(rule.antecedent.begin(), rule.antecedent.end());
+        rule.antecedent.erase(std::unique(rule.antecedent.begin(), rule.antecedent.end()), rule.antecedent.end());
+        for (const auto& consequentPair : rulePair.second) {
+            rule.consequents.emplace_back(std::stoi(consequentPair.first), consequentPair.second);
+        }
+        parsedRules.push_back(std::move(rule));
+    }
     std::cout << "Loaded " << associationRules.size() << " antecedent rules." << std::endl;
     return true;
 }
 
-void EdgeServer::handleCloudResponse(Timestamp time, ObjectID objectId, DeviceID deviceId) {
+void EdgeServer::indexObjectLocations() {
+    objectIndex = SpatialIndex(fovRadius);
+    for (const auto& objectPair : objectLocations) {
+        objectIndex.insert(objectPair.first, objectPair.second);
+    }
+}
+
+void EdgeServer::handleCloudResponse(Timestamp time, ObjectID objectId, DeviceID deviceId, int lodLevel, int deviceStartLevel) {
     currentTime = time;
-    int objectSize = getObjectSize(objectId);
+    int levelSize = getLODSize(objectId, lodLevel);
+    int cachedLevels = getCachedLevels(objectId);
+
+    // A confident trajectory prediction is admitted on its own, since nobody has requested the object yet
+    bool confidentPrediction = false;
+    auto pendingPrefetch = deviceId == -1 ? pendingPrefetches.find(objectId) : pendingPrefetches.end();
+    if (pendingPrefetch != pendingPrefetches.end()) {
+        confidentPrediction = pendingPrefetch->second >= trajectoryAdmissionScore;
+        if (lodLevel == getLODCount(objectId) - 1) {
+            pendingPrefetches.erase(pendingPrefetch);
+        }
+    }
+
+    if (deviceId != -1 && lodLevel >= deviceStartLevel) { // Lower levels were fetched only to complete the edge's copy
+        Timestamp deliveryTime = scheduleDeviceDelivery(time, deviceId, objectId, lodLevel);
+        eventQueue->push(new DeviceResponseEvent(deliveryTime, deviceId, objectId, lodLevel)); // Respond whether or not the edge caches it
+    }
+
+    if (lodLevel < cachedLevels) {
+        edgeCache[objectId] = time;
+        std::cout << time << ": Edge " << serverId << " re-received object " << objectId << " (level " << lodLevel << "). Updated access time." << std::endl;
+        return;
+    }
+    if (lodLevel > cachedLevels) {
+        // A refinement is only useful on top of the levels below it
+        std::cout << time << ": Edge " << serverId << " cannot cache level " << lodLevel << " of object " << objectId << " without level " << cachedLevels << "." << std::endl;
+        return;
+    }
+
+    int objectSize = getLODBytes(objectId, lodLevel + 1);
     if (objectSize > edgeCacheSizeLimit) {
         std::cout << time << ": Edge " << serverId << " cannot cache object " << objectId << " (size " << objectSize << " exceeds limit " << edgeCacheSizeLimit << ")." << std::endl;
-        eventQueue->push(new DeviceResponseEvent(time, deviceId, objectId)); // Still respond to the device
         return;
     }
 
-    if (edgeCache.find(objectId) == edgeCache.end()) {
-        while (currentEdgeCacheSize + objectSize > edgeCacheSizeLimit && !edgeCache.empty()) {
-            evictLRUObject();
-        }
-        if (currentEdgeCacheSize + objectSize <= edgeCacheSizeLimit) {
-            edgeCache[objectId] = time;
-            currentEdgeCacheSize += objectSize;
-            std::cout << time << ": Edge " << serverId << " received and cached object " << objectId << " (size " << objectSize << ") from cloud (for device " << deviceId << "). Current cache size: " << currentEdgeCacheSize << std::endl;
-        } else {
-            std::cout << time << ": Edge " << serverId << " received object " << objectId << ", but no space to cache." << std::endl;
-        }
-        eventQueue->push(new DeviceResponseEvent(time, deviceId, objectId));
+    if (makeRoomFor(objectId, levelSize, deviceId == -1, confidentPrediction)) { // Device ID -1 marks a prefetch arrival
+        edgeCache[objectId] = time;
+        edgeCacheLevels[objectId] = lodLevel + 1;
+        currentEdgeCacheSize += levelSize;
+        std::cout << time << ": Edge " << serverId << " received and cached object " << objectId << " level " << lodLevel << " (size " << levelSize << ") from cloud (for device " << deviceId << "). Current cache size: " << currentEdgeCacheSize << std::endl;
+    } else {
+        std::cout << time << ": Edge " << serverId << " received object " << objectId << " level " << lodLevel << ", but no space to cache." << std::endl;
+    }
+    if (lodLevel == 0) {
         // Trigger prefetching logic here (e.g., based on this new arrival)
         triggerPrefetching(time);
-    } else {
-        edgeCache[objectId] = time;
-        std::cout << time << ": Edge " << serverId << " re-received object " << objectId << ". Updated access time." << std::endl;
-        eventQueue->push(new DeviceResponseEvent(time, deviceId, objectId));
     }
 }
 
@@ -86,16 +132,17 @@ void EdgeServer::triggerPrefetching(Timestamp time) {
     // Implement your prefetching algorithm here, considering object sizes
     // Example: If object 3 is to be prefetched
     ObjectID prefetchObjectId = 3;
-    int prefetchObjectSize = getObjectSize(prefetchObjectId);
+    int prefetchObjectSize = getLODBytes(prefetchObjectId, getLODCount(prefetchObjectId));
 
     std::cout << time << ": Edge " << serverId << " considers prefetching object " << prefetchObjectId << " (size " << prefetchObjectSize << ")." << std::endl;
 
-    if (edgeCache.find(prefetchObjectId) == edgeCache.end() && prefetchObjectSize <= edgeCacheSizeLimit) {
-        while (currentEdgeCacheSize + prefetchObjectSize > edgeCacheSizeLimit && !edgeCache.empty()) {
-            evictLRUObject();
-        }
-        if (currentEdgeCacheSize + prefetchObjectSize <= edgeCacheSizeLimit) {
+    if (edgeCache.find(prefetchObjectId) == edgeCache.end() && pendingPrefetches.count(prefetchObjectId) == 0
+        && prefetchObjectSize <= edgeCacheSizeLimit) {
+        // Only check admission now; space is made level by level when the data arrives
+        std::vector<ObjectID> victims;
+        if (selectVictimsFor(prefetchObjectId, prefetchObjectSize, true, false, victims)) {
             std::cout << time << ": Edge " << serverId << " initiates prefetching for object " << prefetchObjectId << "." << std::endl;
+            pendingPrefetches[prefetchObjectId] = 0.0;
             eventQueue->push(new CloudRequestEvent(time, serverId, prefetchObjectId, -1)); // Device ID -1 indicates it's a prefetch
         } else {
             std::cout << time << ": Edge " << serverId << " cannot prefetch object " << prefetchObjectId << " due to insufficient cache space." << std::endl;
@@ -103,15 +150,68 @@ void EdgeServer::triggerPrefetching(Timestamp time) {
     }
 }
 
-void EdgeServer::evictLRUObject() {
-    if (edgeCache.empty()) return;
+void EdgeServer::enableAdmissionFilter(int expectedObjects, int prefetchThreshold) {
+    admissionFilterEnabled = true;
+    prefetchAdmissionThreshold = prefetchThreshold;
+    frequencySketch.resize(expectedObjects);
+    std::cout << "Edge " << serverId << " enabled admission filter (" << frequencySketch.memoryBytes() << " bytes of sketch for " << expectedObjects << " objects, prefetch threshold " << prefetchThreshold << ")." << std::endl;
+}
+
+bool EdgeServer::makeRoomFor(ObjectID objectId, int objectSize, bool isPrefetch, bool confidentPrediction) {
+    ProfileScope scope(profiler, "edge make room");
+    std::vector<ObjectID> victims;
+    if (!selectVictimsFor(objectId, objectSize, isPrefetch, confidentPrediction, victims)) {
+        return false;
+    }
+    for (ObjectID victimId : victims) {
+        evictObject(victimId);
+    }
+    return true;
+}
+
+bool EdgeServer::selectVictimsFor(ObjectID objectId, int objectSize, bool isPrefetch, bool confidentPrediction, std::vector<ObjectID>& victims) {
+    bool checkFrequency = admissionFilterEnabled && !confidentPrediction;
+    if (checkFrequency && isPrefetch && currentEdgeCacheSize + objectSize > edgeCacheSizeLimit) {
+        // Speculative objects may only displace cached content once they have been requested often enough
+        int frequency = frequencySketch.estimate(objectId);
+        if (frequency < prefetchAdmissionThreshold) {
+            std::cout << currentTime << ": Edge " << serverId << " admission filter rejected prefetched object " << objectId << " (frequency " << frequency << " below threshold " << prefetchAdmissionThreshold << ")." << std::endl;
+            return false;
+        }
+    }
+
+    // Pick every victim needed first, so a rejection or a shortfall never evicts anything
+    victims.clear();
+    std::unordered_set<ObjectID> excludedIds = {objectId}; // Never evict the object being made room for
+    int freedSize = 0;
+    while (currentEdgeCacheSize - freedSize + objectSize > edgeCacheSizeLimit) {
+        ObjectID victimId = selectEvictionVictim(excludedIds);
+        if (victimId == -1) break;
+        if (checkFrequency) {
+            // TinyLFU: only evict the victims if the newcomer is estimated to be more popular than each of them
+            int candidateFrequency = frequencySketch.estimate(objectId);
+            int victimFrequency = frequencySketch.estimate(victimId);
+            if (candidateFrequency <= victimFrequency) {
+                std::cout << currentTime << ": Edge " << serverId << " admission filter rejected object " << objectId << " (frequency " << candidateFrequency << " vs victim " << victimId << " frequency " << victimFrequency << ")." << std::endl;
+                return false;
+            }
+        }
+        victims.push_back(victimId);
+        excludedIds.insert(victimId);
+        freedSize += getLODBytes(victimId, getCachedLevels(victimId));
+    }
+    return currentEdgeCacheSize - freedSize + objectSize <= edgeCacheSizeLimit;
+}
 
-    ObjectID lruObjectId;
-    Timestamp minTime = currentTime;
+ObjectID EdgeServer::selectEvictionVictim(const std::unordered_set<ObjectID>& excludedIds) {
+    ProfileScope scope(profiler, "eviction victim");
+    ObjectID lruObjectId = -1;
+    Timestamp minTime = std::numeric_limits<Timestamp>::max();
     double maxDistance = 0.0; // Evict the furthest object
-    ObjectID furthestObjectId;
+    ObjectID furthestObjectId = -1;
 
     for (const auto& pair : edgeCache) {
+        if (excludedIds.count(pair.first)) continue;
         if (pair.second < minTime) {
             minTime = pair.second;
             lruObjectId = pair.first;
@@ -129,138 +229,202 @@ void EdgeServer::evictLRUObject() {
     if (edgeCache.find(objectToEvict) == edgeCache.end()) {
         objectToEvict = lruObjectId; // Evict LRU if furthest not found
     }
+    return objectToEvict;
+}
 
-    int evictedSize = getObjectSize(objectToEvict);
+void EdgeServer::evictObject(ObjectID objectToEvict) {
+    int evictedSize = getLODBytes(objectToEvict, getCachedLevels(objectToEvict));
     edgeCache.erase(objectToEvict);
+    edgeCacheLevels.erase(objectToEvict);
     currentEdgeCacheSize -= evictedSize;
     std::cout << currentTime << ": Edge " << serverId << " evicted object " << objectToEvict << " (size " << evictedSize << ") due to cache full. New cache size: " << currentEdgeCacheSize << std::endl;
 }
 
-int EdgeServer::getObjectSize(ObjectID objectId) {
-    if (objectSizes.count(objectId)) {
-        return objectSizes[objectId];
-    }
-    return 0; // Default size if not found
+int EdgeServer::getCachedLevels(ObjectID objectId) {
+    auto it = edgeCacheLevels.find(objectId);
+    return it != edgeCacheLevels.end() ? it->second : 0;
+}
+
+Timestamp EdgeServer::deviceTransferTime(ObjectID objectId, int lodLevel) {
+    return deviceBandwidth > 0.0 ? getLODSize(objectId, lodLevel) / deviceBandwidth : 0.0;
+}
+
+Timestamp EdgeServer::scheduleDeviceDelivery(Timestamp time, DeviceID deviceId, ObjectID objectId, int lodLevel) {
+    // Levels share the device's link, so each one waits for the transfers queued before it
+    Timestamp& linkFreeAt = deviceLinkFreeAt[deviceId];
+    linkFreeAt = std::max(time, linkFreeAt) + deviceTransferTime(objectId, lodLevel);
+    return linkFreeAt;
 }
 
-std::vector<ObjectID> EdgeServer::getPrefetchCandidates(const std::unordered_set<ObjectID>& interactedObjects) {
+std::vector<PrefetchCandidate> EdgeServer::getPrefetchCandidates(ARDevice* requestingDevice, bool useRules) {
+    ProfileScope scope(profiler, "prefetch candidates");
     std::unordered_map<ObjectID, double> candidateConfidences;
-    std::vector<ObjectID> prefetchCandidates;
-
-    // Create a string representation of the interacted objects (antecedent)
-    std::vector<ObjectID> sortedInteracted(interactedObjects.begin(), interactedObjects.end());
-    std::sort(sortedInteracted.begin(), sortedInteracted.end());
-    std::string antecedentKey;
-    for (size_t i = 0; i < sortedInteracted.size(); ++i) {
-        antecedentKey += std::to_string(sortedInteracted[i]);
-        if (i < sortedInteracted.size() - 1) {
-            antecedentKey += " ";
-        }
-    }
+    std::unordered_map<ObjectID, double> trajectoryScores;
+    std::vector<PrefetchCandidate> prefetchCandidates;
+    const InteractionHistory& interactedObjects = requestingDevice->interactedObjects;
 
-    // Check for rules matching the current set of interacted objects
-    if (associationRules.count(antecedentKey)) {
-        for (const auto& consequentPair : associationRules[antecedentKey]) {
-            ObjectID consequentId = std::stoi(consequentPair.first);
-            double confidence = consequentPair.second;
-            if (edgeCache.find(consequentId) == edgeCache.end()) { // Don't prefetch if already in cache
-                candidateConfidences[consequentId] = confidence;
+    if (useRules) {
+        // Check for a rule matching the current set of interacted objects; the history iterates in sorted order
+        auto exactMatch = std::find_if(parsedRules.begin(), parsedRules.end(), [&](const ParsedRule& rule) {
+            return std::equal(rule.antecedent.begin(), rule.antecedent.end(), interactedObjects.begin(), interactedObjects.end());
+        });
+        if (exactMatch != parsedRules.end()) {
+            for (const auto& consequentPair : exactMatch->consequents) {
+                ObjectID consequentId = consequentPair.first;
+                double confidence = consequentPair.second;
+                if (edgeCache.find(consequentId) == edgeCache.end()) { // Don't prefetch if already in cache
+                    candidateConfidences[consequentId] = confidence;
+                }
             }
         }
-    }
-
-    // If no direct match, consider rules where the antecedent is a subset
-    for (const auto& rulePair : associationRules) {
-        std::stringstream ss(rulePair.first);
-        std::string segment;
-        std::unordered_set<ObjectID> ruleAntecedent;
-        while (ss >> segment) {
-            ruleAntecedent.insert(std::stoi(segment));
-        }
 
-        // Check if the rule's antecedent is a subset of the interacted objects
-        if (std::includes(interactedObjects.begin(), interactedObjects.end(),
-                          ruleAntecedent.begin(), ruleAntecedent.end())) {
-            for (const auto& consequentPair : rulePair.second) {
-                ObjectID consequentId = std::stoi(consequentPair.first);
-                double confidence = consequentPair.second;
-                if (edgeCache.find(consequentId) == edgeCache.end()) {
-                    // Aggregate confidence (you might want a more sophisticated aggregation)
-                    candidateConfidences[consequentId] += confidence;
+        // If no direct match, consider rules where the antecedent is a subset
+        for (const ParsedRule& rule : parsedRules) {
+            // Check if the rule's antecedent is a subset of the interacted objects
+            if (std::includes(interactedObjects.begin(), interactedObjects.end(),
+                              rule.antecedent.begin(), rule.antecedent.end())) {
+                for (const auto& consequentPair : rule.consequents) {
+                    ObjectID consequentId = consequentPair.first;
+                    double confidence = consequentPair.second;
+                    if (edgeCache.find(consequentId) == edgeCache.end()) {
+                        // Aggregate confidence (you might want a more sophisticated aggregation)
+                        candidateConfidences[consequentId] += confidence;
+                    }
                 }
             }
         }
     }
 
-    // Filter candidates based on proximity to AR device
-    double fovRadius = 10.0; // Example FoV radius
-    ARDevice* requestingDevice = nullptr;
-    if (simulationDevices) {
-        if (simulationDevices->count(1)) { // Assuming device ID 1 for now
-            requestingDevice = simulationDevices->at(1);
-            for (const auto& candidatePair : candidateConfidences) {
-                ObjectID candidateId = candidatePair.first;
-                double distance = calculateDistance(requestingDevice->location, objectLocations[candidateId]);
-                if (distance <= fovRadius) {
-                    prefetchCandidates.push_back(candidateId);
-                } else {
-                    // Store metadata temporarily
-                    ObjectInfo tempObj;
-                    tempObj.id = candidateId;
-                    tempObj.location = objectLocations[candidateId];
-                    tempMetadata.push_back(tempObj);
-                    std::cout << currentTime << ": Edge " << serverId << " storing metadata for object " << candidateId << " (distance: " << distance << ")" << std::endl;
-                }
+    // Score objects near where the device is heading by how sure we are it gets there
+    MobilityPredictor::Prediction prediction = {requestingDevice->location, 0.0};
+    bool usePrediction = false;
+    if (predictionHorizon > 0.0) {
+        prediction = requestingDevice->mobility.predict(currentTime + predictionHorizon, fovRadius);
+        usePrediction = prediction.confidence >= minPredictionConfidence;
+    }
+    if (usePrediction) {
+        // Only the grid cells around the predicted position are visited, not the whole catalog
+        objectIndex.queryRadius(prediction.location, fovRadius, nearbyObjects);
+        for (ObjectID nearbyId : nearbyObjects) {
+            if (edgeCache.find(nearbyId) == edgeCache.end()
+                && !interactedObjects.contains(nearbyId)) { // Recently seen objects are already on their way
+                double distance = calculateDistance(prediction.location, objectLocations[nearbyId]);
+                double trajectoryScore = prediction.confidence * (1.0 - distance / fovRadius);
+                trajectoryScores[nearbyId] = trajectoryScore;
+                candidateConfidences[nearbyId] += trajectoryScore; // One score: rule confidence plus trajectory term
             }
         }
     }
 
-    // Sort candidates by confidence (descending)
-    std::vector<std::pair<ObjectID, double>> sortedCandidates(candidateConfidences.begin(), candidateConfidences.end());
-    std::sort(sortedCandidates.begin(), sortedCandidates.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second;
+    // Filter candidates based on proximity to the AR device, now or at its predicted position
+    std::vector<PrefetchCandidate> rankedCandidates;
+    for (const auto& candidatePair : candidateConfidences) {
+        ObjectID candidateId = candidatePair.first;
+        double distance = calculateDistance(requestingDevice->location, objectLocations[candidateId]);
+        if (usePrediction) {
+            distance = std::min(distance, calculateDistance(prediction.location, objectLocations[candidateId]));
+        }
+        if (distance <= fovRadius) {
+            auto trajectoryIt = trajectoryScores.find(candidateId);
+            rankedCandidates.push_back({candidateId, candidatePair.second, trajectoryIt != trajectoryScores.end() ? trajectoryIt->second : 0.0});
+        } else {
+            // Store metadata temporarily
+            ObjectInfo tempObj;
+            tempObj.id = candidateId;
+            tempObj.location = objectLocations[candidateId];
+            tempMetadata.push_back(tempObj);
+            std::cout << currentTime << ": Edge " << serverId << " storing metadata for object " << candidateId << " (distance: " << distance << ")" << std::endl;
+        }
+    }
+
+    // Sort candidates by combined score (descending)
+    std::sort(rankedCandidates.begin(), rankedCandidates.end(), [](const auto& a, const auto& b) {
+        return a.score > b.score;
     });
 
-    // Select the top N candidates (e.g., top 1 for now)
-    size_t numPrefetch = 1;
-    for (size_t i = 0; i < std::min(numPrefetch, sortedCandidates.size()); ++i) {
-        prefetchCandidates.push_back(sortedCandidates[i].first);
+    // Select the top N candidates that score high enough and are not already being prefetched
+    for (const PrefetchCandidate& candidate : rankedCandidates) {
+        if (static_cast<int>(prefetchCandidates.size()) >= prefetchCandidateLimit || candidate.score < minPrefetchScore) {
+            break;
+        }
+        auto pendingPrefetch = pendingPrefetches.find(candidate.id);
+        if (pendingPrefetch == pendingPrefetches.end()) {
+            prefetchCandidates.push_back(candidate);
+        } else {
+            // Already on its way; a firmer prediction still helps it get admitted when it arrives
+            pendingPrefetch->second = std::max(pendingPrefetch->second, candidate.trajectoryScore);
+        }
     }
 
-    std::cout << currentTime << ": Edge " << serverId << " found prefetch candidates based on interacted objects: ";
-    for (ObjectID id : prefetchCandidates) {
-        std::cout << id << "(" << std::fixed << std::setprecision(2) << candidateConfidences[id] << ") ";
+    if (usePrediction) {
+        std::cout << currentTime << ": Edge " << serverId << " predicts device " << requestingDevice->deviceId << " at (" << prediction.location.first << ", " << prediction.location.second << ") in " << predictionHorizon << " (confidence " << prediction.confidence << ")." << std::endl;
+    }
+    std::cout << currentTime << ": Edge " << serverId << " found prefetch candidates" << (useRules ? " based on interacted objects" : " along the predicted trajectory") << ": ";
+    for (const PrefetchCandidate& candidate : prefetchCandidates) {
+        std::cout << candidate.id << "(" << std::fixed << std::setprecision(2) << candidate.score << ") ";
     }
     std::cout << std::endl;
 
     return prefetchCandidates;
 }
 
-void EdgeServer::handleDeviceRequest(Timestamp time, ObjectID objectId, DeviceID deviceId) {
+void EdgeServer::prefetchObjects(Timestamp time, const std::vector<PrefetchCandidate>& candidates, const char* reason) {
+    for (const PrefetchCandidate& candidate : candidates) {
+        int prefetchObjectSize = getLODBytes(candidate.id, getLODCount(candidate.id));
+        if (prefetchObjectSize <= edgeCacheSizeLimit && edgeCache.find(candidate.id) == edgeCache.end()
+            && pendingPrefetches.count(candidate.id) == 0) {
+            // Basic prefetching: just request it
+            std::cout << time << ": Edge " << serverId << " initiating prefetch for object " << candidate.id << " due to " << reason << "." << std::endl;
+            pendingPrefetches[candidate.id] = candidate.trajectoryScore;
+            eventQueue->push(new CloudRequestEvent(time, serverId, candidate.id, -1));
+        }
+    }
+}
+
+void EdgeServer::handleDeviceMove(Timestamp time, DeviceID deviceId) {
+    currentTime = time;
+    if (predictionHorizon <= 0.0 || !simulationDevices || !simulationDevices->count(deviceId)) {
+        return;
+    }
+    // Look ahead along the device's trajectory so objects it walks towards are already at the edge.
+    // Rules only change on requests, so this pass considers the trajectory alone.
+    prefetchObjects(time, getPrefetchCandidates((*simulationDevices)[deviceId], false), "device movement");
+}
+
+void EdgeServer::handleDeviceRequest(Timestamp time, ObjectID objectId, DeviceID deviceId, int startLevel) {
     currentTime = time;
     std::cout << time << ": Edge " << serverId << " received request for object " << objectId << " from device " << deviceId << std::endl;
-    if (edgeCache.find(objectId) == edgeCache.end()) {
+    if (admissionFilterEnabled) {
+        frequencySketch.increment(objectId);
+    }
+    int cachedLevels = getCachedLevels(objectId);
+    if (cachedLevels == 0) {
         // Cache miss, try prefetching
         // First, get the interacted objects of the requesting device
         ARDevice* requestingDevice = nullptr;
         if (simulationDevices) { // Assuming you have a way to access the devices map
             if (simulationDevices->count(deviceId)) {
                 requestingDevice = (*simulationDevices)[deviceId];
-                std::vector<ObjectID> candidates = getPrefetchCandidates(requestingDevice->interactedObjects);
-                for (ObjectID candidateId : candidates) {
-                    int prefetchObjectSize = getObjectSize(candidateId);
-                    if (prefetchObjectSize <= edgeCacheSizeLimit && edgeCache.find(candidateId) == edgeCache.end()) {
-                        // Basic prefetching: just request it
-                        std::cout << time << ": Edge " << serverId << " initiating prefetch for object " << candidateId << " due to device request." << std::endl;
-                        eventQueue->push(new CloudRequestEvent(time, serverId, candidateId, -1));
-                    }
-                }
+                prefetchObjects(time, getPrefetchCandidates(requestingDevice), "device request");
             }
         }
-        eventQueue->push(new CloudRequestEvent(time, serverId, objectId, deviceId)); // Still forward the original request
+        // Still forward the original request, fetching from the coarsest level so the edge can cache the object
+        eventQueue->push(new CloudRequestEvent(time, serverId, objectId, deviceId, 0, startLevel));
     } else {
-        std::cout << time << ": Edge " << serverId << " found object " << objectId << " in edge cache." << std::endl;
+        int lodCount = getLODCount(objectId);
+        if (cachedLevels < lodCount) {
+            std::cout << time << ": Edge " << serverId << " found " << cachedLevels << " of " << lodCount << " levels of detail of object " << objectId << " in edge cache." << std::endl;
+        } else {
+            std::cout << time << ": Edge " << serverId << " found object " << objectId << " in edge cache." << std::endl;
+        }
         edgeCache[objectId] = time;
-        eventQueue->push(new DeviceResponseEvent(time, deviceId, objectId));
+        // Send the cached levels coarsest first, then fetch any missing refinements from the cloud
+        for (int level = startLevel; level < cachedLevels; ++level) {
+            Timestamp deliveryTime = scheduleDeviceDelivery(time, deviceId, objectId, level);
+            eventQueue->push(new DeviceResponseEvent(deliveryTime, deviceId, objectId, level));
+        }
+        if (cachedLevels < lodCount) {
+            eventQueue->push(new CloudRequestEvent(time, serverId, objectId, deviceId, cachedLevels, startLevel));
+        }
     }
 }
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include "cloud.h"
 #include <iostream>
 
-Event::Event(Timestamp time) : timestamp(time) {} 
+uint64_t Event::nextSequence = 0;
+
+Event::Event(Timestamp time) : timestamp(time), sequence(nextSequence++) {} 
 
 UserSeesObjectEvent::UserSeesObjectEvent(Timestamp time, DeviceID dId, ObjectID oId) : Event(time), deviceId(dId), objectId(oId) {}
 void UserSeesObjectEvent::process(std::map<DeviceID, ARDevice*>& devices,
@@ -16,40 +18,52 @@ void UserSeesObjectEvent::process(std::map<DeviceID, ARDevice*>& devices,
     }
 }
 
-EdgeRequestEvent::EdgeRequestEvent(Timestamp time, DeviceID dId, ObjectID oId) : Event(time), deviceId(dId), objectId(oId) {}
+EdgeRequestEvent::EdgeRequestEvent(Timestamp time, DeviceID dId, ObjectID oId, int startLod) : Event(time), deviceId(dId), objectId(oId), startLevel(startLod) {}
 void EdgeRequestEvent::process(std::map<DeviceID, ARDevice*>& devices,
                                 std::map<ServerID, EdgeServer*>& servers,
                                 Cloud& cloud,
                                 std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
     if (servers.count(1)) { // Assuming a single edge server with ID 1
-        servers[1]->handleDeviceRequest(timestamp, objectId, deviceId);
+        servers[1]->handleDeviceRequest(timestamp, objectId, deviceId, startLevel);
     }
 }
 
-CloudRequestEvent::CloudRequestEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId) : Event(time), serverId(sId), objectId(oId), requestingDeviceId(dId) {}
+CloudRequestEvent::CloudRequestEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId, int startLod, int deviceStartLod) : Event(time), serverId(sId), objectId(oId), requestingDeviceId(dId), startLevel(startLod), deviceStartLevel(deviceStartLod) {}
 void CloudRequestEvent::process(std::map<DeviceID, ARDevice*>& devices,
                                  std::map<ServerID, EdgeServer*>& servers,
                                  Cloud& cloud,
                                  std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
-    cloud.processRequest(timestamp, objectId, serverId, requestingDeviceId, eventQueue);
+    cloud.processRequest(timestamp, objectId, serverId, requestingDeviceId, startLevel, deviceStartLevel, eventQueue);
 }
 
-DeviceResponseEvent::DeviceResponseEvent(Timestamp time, DeviceID dId, ObjectID oId) : Event(time), deviceId(dId), objectId(oId) {}
+DeviceResponseEvent::DeviceResponseEvent(Timestamp time, DeviceID dId, ObjectID oId, int lod) : Event(time), deviceId(dId), objectId(oId), lodLevel(lod) {}
 void DeviceResponseEvent::process(std::map<DeviceID, ARDevice*>& devices,
                                   std::map<ServerID, EdgeServer*>& servers,
                                   Cloud& cloud,
                                   std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
     if (devices.count(deviceId)) {
-        devices[deviceId]->receiveObject(timestamp, objectId);
+        devices[deviceId]->receiveObject(timestamp, objectId, lodLevel);
     }
 }
 
-EdgeResponseEvent::EdgeResponseEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId) : Event(time), serverId(sId), objectId(oId), targetDeviceId(dId) {}
+EdgeResponseEvent::EdgeResponseEvent(Timestamp time, ServerID sId, ObjectID oId, DeviceID dId, int lod, int deviceStartLod) : Event(time), serverId(sId), objectId(oId), targetDeviceId(dId), lodLevel(lod), deviceStartLevel(deviceStartLod) {}
 void EdgeResponseEvent::process(std::map<DeviceID, ARDevice*>& devices,
                                  std::map<ServerID, EdgeServer*>& servers,
                                  Cloud& cloud,
                                  std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
     if (servers.count(serverId)) {
-        servers[serverId]->handleCloudResponse(timestamp, objectId, targetDeviceId);
+        servers[serverId]->handleCloudResponse(timestamp, objectId, targetDeviceId, lodLevel, deviceStartLevel);
+    }
+}
+
+void ARDeviceMoveEvent::process(std::map<DeviceID, ARDevice*>& devices,
+                                std::map<ServerID, EdgeServer*>& servers,
+                                Cloud& cloud,
+                                std::priority_queue<Event*, std::vector<Event*>, std::function<bool(Event*, Event*)>>& eventQueue) {
+    if (devices.count(deviceId)) {
+        devices[deviceId]->move(timestamp, newLocation);
+        if (servers.count(1)) { // Assuming a single edge server with ID 1
+            servers[1]->handleDeviceMove(timestamp, deviceId);
+        }
     }
 }
\ No newline at end of file
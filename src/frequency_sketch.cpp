@@ -0,0 +1,76 @@
+#include "frequency_sketch.h"
+#include <algorithm>
+
+namespace {
+
+const uint64_t kRowSeeds[] = {
+    0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL
+};
+
+uint64_t mixHash(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+FrequencySketch::FrequencySketch(int expectedObjects) {
+    resize(expectedObjects);
+}
+
+void FrequencySketch::resize(int expectedObjects) {
+    rowWidth = 16; // At least one word per row
+    while (rowWidth < static_cast<uint64_t>(std::max(expectedObjects, 1))) {
+        rowWidth <<= 1;
+    }
+    table.assign(kDepth * rowWidth / 16, 0);
+    sampleSize = static_cast<int>(10 * rowWidth);
+    additions = 0;
+}
+
+uint64_t FrequencySketch::counterIndex(ObjectID objectId, int row) const {
+    uint64_t hash = mixHash(static_cast<uint64_t>(static_cast<uint32_t>(objectId)) + kRowSeeds[row]);
+    return row * rowWidth + (hash & (rowWidth - 1));
+}
+
+void FrequencySketch::increment(ObjectID objectId) {
+    for (int row = 0; row < kDepth; ++row) {
+        uint64_t index = counterIndex(objectId, row);
+        uint64_t& word = table[index >> 4];
+        int shift = static_cast<int>(index & 15) * 4;
+        if (((word >> shift) & 0xF) < kMaxCount) {
+            word += 1ULL << shift;
+        }
+    }
+    // Every access counts towards the sample, so saturated counters still age
+    if (++additions >= sampleSize) {
+        age();
+    }
+}
+
+int FrequencySketch::estimate(ObjectID objectId) const {
+    int frequency = kMaxCount;
+    for (int row = 0; row < kDepth; ++row) {
+        uint64_t index = counterIndex(objectId, row);
+        int shift = static_cast<int>(index & 15) * 4;
+        frequency = std::min(frequency, static_cast<int>((table[index >> 4] >> shift) & 0xF));
+    }
+    return frequency;
+}
+
+void FrequencySketch::age() {
+    // Halve every counter: shift the whole word and drop the bit that leaked in from the next counter
+    for (uint64_t& word : table) {
+        word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    additions /= 2;
+}
+
+size_t FrequencySketch::memoryBytes() const {
+    return table.size() * sizeof(uint64_t);
+}
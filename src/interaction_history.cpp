@@ -0,0 +1,53 @@
+#include "interaction_history.h"
+#include <algorithm>
+
+InteractionHistory::InteractionHistory(int capacity, Timestamp window)
+    : capacity(std::max(capacity, 1)), window(window) {
+    objectIds.reserve(this->capacity);
+    lastSeen.reserve(this->capacity);
+}
+
+void InteractionHistory::record(Timestamp time, ObjectID objectId) {
+    expire(time);
+
+    auto it = std::lower_bound(objectIds.begin(), objectIds.end(), objectId);
+    size_t index = it - objectIds.begin();
+    if (it != objectIds.end() && *it == objectId) {
+        lastSeen[index] = time;
+        return;
+    }
+
+    if (static_cast<int>(objectIds.size()) >= capacity) {
+        // Replace the least recently seen object
+        size_t oldest = std::min_element(lastSeen.begin(), lastSeen.end()) - lastSeen.begin();
+        eraseAt(oldest);
+        if (oldest < index) {
+            --index;
+        }
+    }
+    objectIds.insert(objectIds.begin() + index, objectId);
+    lastSeen.insert(lastSeen.begin() + index, time);
+}
+
+void InteractionHistory::expire(Timestamp time) {
+    if (window <= 0.0) return;
+    size_t kept = 0;
+    for (size_t i = 0; i < objectIds.size(); ++i) {
+        if (time - lastSeen[i] <= window) {
+            objectIds[kept] = objectIds[i];
+            lastSeen[kept] = lastSeen[i];
+            ++kept;
+        }
+    }
+    objectIds.resize(kept);
+    lastSeen.resize(kept);
+}
+
+bool InteractionHistory::contains(ObjectID objectId) const {
+    return std::binary_search(objectIds.begin(), objectIds.end(), objectId);
+}
+
+void InteractionHistory::eraseAt(size_t index) {
+    objectIds.erase(objectIds.begin() + index);
+    lastSeen.erase(lastSeen.begin() + index);
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <string>
 
 #include "ar_device.h"
 #include "edge_server.h"
@@ -17,6 +18,14 @@ std::map<ObjectID, int> objectSizes = {
     {5, 15}
 };
 
+// Define levels of detail (ObjectID -> incremental size per level, coarsest first)
+// Objects not listed here are delivered in one piece
+std::map<ObjectID, std::vector<int>> objectLODSizes = {
+    {1, {2, 3, 6}},
+    {3, {3, 4, 7}},
+    {5, {3, 5, 9}}
+};
+
 // Define object locations
 std::map<ObjectID, Location> objectLocations = {
     {1, {1.0, 2.0}},
@@ -26,22 +35,39 @@ std::map<ObjectID, Location> objectLocations = {
     {5, {9.0, 10.0}}
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     SimulationEngine engine; // Create the SimulationEngine object
 
+    // --profile reports per-event-type timing at the end of the run, --profile-hw adds hardware counters
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--profile") {
+            engine.profiler.enable();
+        } else if (arg == "--profile-hw") {
+            engine.profiler.enable(true);
+        }
+    }
+
     // Create multiple devices with cache limits
     std::map<DeviceID, ARDevice*> devices;
     devices[1] = new ARDevice(1, 20, &engine.eventQueue, {0.0, 0.0}); // Initial location (0, 0)
     devices[2] = new ARDevice(2, 15, &engine.eventQueue, {2.0, 2.0});
     devices[3] = new ARDevice(3, 25, &engine.eventQueue, {4.0, 4.0});
 
-    // Add a move event
+    // Add move events: device 1 walks diagonally towards the objects
+    engine.addEvent(new ARDeviceMoveEvent(4.0, 1, {0.5, 0.5}));
+    engine.addEvent(new ARDeviceMoveEvent(6.0, 1, {2.0, 2.0}));
+    engine.addEvent(new ARDeviceMoveEvent(8.0, 1, {3.5, 3.5}));
     engine.addEvent(new ARDeviceMoveEvent(10.0, 1, {5.0, 5.0})); // Move device 1 at time 10.0
 
     // Create edge server with a cache limit
     std::map<ServerID, EdgeServer*> servers;
     servers[1] = new EdgeServer(1, 50, &engine.eventQueue, "association_rule.txt");
+    servers[1]->deviceBandwidth = 50.0; // Edge-to-device link, size units per time unit
+    servers[1]->predictionHorizon = 2.0; // Prefetch for where devices will be 2 time units ahead
+    engine.cloud.bandwidth = 20.0; // Cloud-to-edge link, size units per time unit
     servers[1]->simulationDevices = &engine.devices; // Set the devices map
+    servers[1]->enableAdmissionFilter(static_cast<int>(objectSizes.size())); // Optional TinyLFU-style cache admission
 
     // Add devices and servers to the engine (if you want to manage them explicitly there)
     engine.addDevice(devices[1]);
@@ -60,6 +86,7 @@ int main() {
     engine.addEvent(new UserSeesObjectEvent(3.0, 1, 4));
     engine.addEvent(new UserSeesObjectEvent(4.0, 2, 1));
     engine.addEvent(new UserSeesObjectEvent(5.0, 3, 2));
+    engine.addEvent(new UserSeesObjectEvent(12.0, 1, 5)); // Reached the far corner; prefetched along the way
 
     engine.run(); // Run the simulation using the engine's run method
 
@@ -0,0 +1,83 @@
+#include "mobility_predictor.h"
+#include <algorithm>
+#include <cmath>
+
+MobilityPredictor::MobilityPredictor(int historySize) : historySize(std::max(historySize, kMinSamples)) {
+    times.reserve(this->historySize);
+    locations.reserve(this->historySize);
+}
+
+size_t MobilityPredictor::newestIndex() const {
+    return (next + times.size() - 1) % times.size();
+}
+
+void MobilityPredictor::addSample(Timestamp time, Location location) {
+    if (!times.empty() && times[newestIndex()] == time) {
+        locations[newestIndex()] = location; // Same instant, keep the latest position
+        return;
+    }
+    if (static_cast<int>(times.size()) < historySize) {
+        times.push_back(time);
+        locations.push_back(location);
+    } else {
+        times[next] = time;
+        locations[next] = location;
+    }
+    next = (next + 1) % historySize;
+}
+
+MobilityPredictor::Prediction MobilityPredictor::predict(Timestamp time, double tolerance) const {
+    if (times.empty()) {
+        return {{0.0, 0.0}, 0.0};
+    }
+    size_t newest = newestIndex();
+    size_t n = times.size();
+    if (n < static_cast<size_t>(kMinSamples)) {
+        return {locations[newest], 0.0}; // Too few samples to tell a trend from noise
+    }
+
+    // Least-squares fit of x(t) and y(t) around the mean sample time
+    double meanT = 0.0, meanX = 0.0, meanY = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        meanT += times[i];
+        meanX += locations[i].first;
+        meanY += locations[i].second;
+    }
+    meanT /= n;
+    meanX /= n;
+    meanY /= n;
+
+    double varT = 0.0, covX = 0.0, covY = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dt = times[i] - meanT;
+        varT += dt * dt;
+        covX += dt * (locations[i].first - meanX);
+        covY += dt * (locations[i].second - meanY);
+    }
+    double velocityX = covX / varT;
+    double velocityY = covY / varT;
+
+    double squaredResiduals = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dt = times[i] - meanT;
+        double rx = locations[i].first - (meanX + velocityX * dt);
+        double ry = locations[i].second - (meanY + velocityY * dt);
+        squaredResiduals += rx * rx + ry * ry;
+    }
+    double residualRms = n > 2 ? std::sqrt(squaredResiduals / (n - 2)) : 0.0;
+
+    // Extrapolate from the newest sample so a turn shows up as soon as possible. Moves are
+    // discrete, so a device that stopped reporting may have stopped walking: cap how far we go.
+    double horizon = std::max(0.0, time - times[newest]);
+    double extrapolation = std::min(horizon, maxExtrapolation);
+    Location predicted = {locations[newest].first + velocityX * extrapolation,
+                          locations[newest].second + velocityY * extrapolation};
+
+    // Position uncertainty grows with the velocity error and the process noise over the whole
+    // horizon, so an old last sample lowers confidence even when the fit is perfect
+    double velocityError = residualRms / std::sqrt(varT);
+    double uncertainty = residualRms + (velocityError + velocityNoise) * horizon;
+    double sampleFactor = std::min(1.0, static_cast<double>(n - 1) / kMinSamples); // Full trust from four samples on
+    double confidence = tolerance > 0.0 ? sampleFactor * std::exp(-uncertainty / tolerance) : 0.0;
+    return {predicted, confidence};
+}
@@ -1,8 +1,11 @@
 #include "simulation_engine.h"
+#include "object_catalog.h"
 #include <iostream>
+#include <typeindex>
+#include <typeinfo>
 
 SimulationEngine::SimulationEngine() :
-    eventQueue([](Event* a, Event* b) { return a->timestamp > b->timestamp; }) {}
+    eventQueue(CompareEvents()) {}
 
 void SimulationEngine::addDevice(ARDevice* device) {
     devices[device->deviceId] = device;
@@ -10,28 +13,66 @@ void SimulationEngine::addDevice(ARDevice* device) {
 
 void SimulationEngine::addServer(EdgeServer* server) {
     servers[server->serverId] = server;
+    server->profiler = &profiler;
 }
 
 void SimulationEngine::addEvent(Event* event) {
     eventQueue.push(event);
 }
 
+void SimulationEngine::reportDeliveryMetrics(std::ostream& out) const {
+    LatencyStats firstRender;
+    LatencyStats fullQuality;
+    long long bytesReceived = 0;
+    for (auto const& [id, device] : devices) {
+        firstRender.merge(device->timeToFirstRender);
+        fullQuality.merge(device->timeToFullQuality);
+        bytesReceived += device->bytesReceived;
+    }
+
+    // Extra bytes spent on progressive encoding compared to sending each object in one piece
+    long long lodOverheadBytes = 0;
+    for (auto const& [objectId, levels] : objectLODSizes) {
+        lodOverheadBytes += getLODBytes(objectId, getLODCount(objectId)) - (objectSizes.count(objectId) ? objectSizes.at(objectId) : 0);
+    }
+
+    out << "=== Delivery metrics ===" << std::endl;
+    out << "Time to first render: " << firstRender.count << " views, mean " << firstRender.mean() << ", max " << firstRender.max << std::endl;
+    out << "Time to full quality: " << fullQuality.count << " views, mean " << fullQuality.mean() << ", max " << fullQuality.max << std::endl;
+    out << "Bytes received by devices: " << bytesReceived << " (catalog LOD overhead: " << lodOverheadBytes << " bytes over " << objectLODSizes.size() << " objects)" << std::endl;
+}
+
 void SimulationEngine::run() {
+    profiler.beginRun();
     while (!eventQueue.empty()) {
-        Event* currentEvent = eventQueue.top();
-        eventQueue.pop();
+        Event* currentEvent;
+        {
+            ProfileScope scope(&profiler, "queue pop");
+            currentEvent = eventQueue.top();
+            eventQueue.pop();
+        }
         currentTime = currentEvent->timestamp;
         std::cout << "Processing event at time: " << currentTime << std::endl;
-        currentEvent->process(devices, servers, cloud, eventQueue);
+        if (profiler.enabled) {
+            uint64_t start = SimulationProfiler::now();
+            currentEvent->process(devices, servers, cloud, eventQueue);
+            profiler.recordEvent(typeid(*currentEvent), SimulationProfiler::now() - start, eventQueue.size());
+        } else {
+            currentEvent->process(devices, servers, cloud, eventQueue);
+        }
         delete currentEvent;
 
         // Example of triggering prefetching periodically
         if (static_cast<int>(currentTime) % 5 == 0) {
             if (servers.count(1)) {
+                ProfileScope scope(&profiler, "periodic prefetch");
                 servers[1]->triggerPrefetching(currentTime);
             }
         }
     }
+    profiler.endRun();
+    profiler.report(std::cout);
+    reportDeliveryMetrics(std::cout);
 
     // Clean up allocated memory
     for (auto const& [id, device] : devices) {
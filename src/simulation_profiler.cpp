@@ -0,0 +1,209 @@
+#include "simulation_profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const kHardwareCounterNames[] = {"cycles", "instructions", "cache-misses", "branch-misses"};
+
+std::string eventTypeName(const std::type_index& type) {
+    std::string name = type.name();
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+    return name;
+}
+
+void printStatsRow(std::ostream& out, const std::string& name, const TimingStats& stats) {
+    out << "  " << std::left << std::setw(24) << name << std::right
+        << std::setw(10) << stats.count
+        << std::setw(12) << std::fixed << std::setprecision(3) << stats.totalNanos / 1e6
+        << std::setw(12) << std::setprecision(3) << (stats.count ? stats.totalNanos / 1e3 / stats.count : 0.0)
+        << std::setw(12) << stats.percentileNanos(0.5) / 1e3
+        << std::setw(12) << stats.percentileNanos(0.99) / 1e3
+        << std::setw(12) << stats.maxNanos / 1e3 << std::endl;
+}
+
+void printStatsHeader(std::ostream& out, const char* title) {
+    out << "  " << std::left << std::setw(24) << title << std::right
+        << std::setw(10) << "count" << std::setw(12) << "total ms" << std::setw(12) << "mean us"
+        << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::endl;
+}
+
+} // namespace
+
+void TimingStats::add(uint64_t nanos) {
+    ++count;
+    totalNanos += nanos;
+    maxNanos = std::max(maxNanos, nanos);
+    int bucket = 0;
+    while (bucket < kHistogramBuckets - 1 && (1ULL << bucket) <= nanos) {
+        ++bucket;
+    }
+    ++histogram[bucket];
+}
+
+uint64_t TimingStats::percentileNanos(double fraction) const {
+    uint64_t target = static_cast<uint64_t>(fraction * count);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+        seen += histogram[bucket];
+        if (seen > target) {
+            return std::min<uint64_t>(1ULL << bucket, maxNanos);
+        }
+    }
+    return maxNanos;
+}
+
+void SimulationProfiler::enable(bool hardwareCounters) {
+    enabled = true;
+    hardwareCountersRequested = hardwareCounters;
+}
+
+void SimulationProfiler::beginRun() {
+    if (!enabled) return;
+    if (hardwareCountersRequested) {
+        openHardwareCounters();
+    }
+    runStartNanos = now();
+    lastSampleNanos = runStartNanos;
+    lastSampleEvents = eventsProcessed;
+}
+
+void SimulationProfiler::endRun() {
+    if (!enabled) return;
+    runEndNanos = now();
+    closeHardwareCounters();
+}
+
+void SimulationProfiler::recordEvent(const std::type_index& eventType, uint64_t nanos, size_t queueDepth) {
+    eventStats[eventType].add(nanos);
+    maxQueueDepth = std::max(maxQueueDepth, queueDepth);
+    ++eventsProcessed;
+
+    uint64_t currentNanos = now();
+    if (currentNanos - lastSampleNanos >= kThroughputSampleNanos) {
+        double intervalSeconds = (currentNanos - lastSampleNanos) / 1e9;
+        throughputSamples.emplace_back((currentNanos - runStartNanos) / 1e9, (eventsProcessed - lastSampleEvents) / intervalSeconds);
+        lastSampleNanos = currentNanos;
+        lastSampleEvents = eventsProcessed;
+    }
+}
+
+void SimulationProfiler::recordSection(const char* name, uint64_t nanos) {
+    auto it = sectionStats.find(name);
+    if (it == sectionStats.end()) {
+        it = sectionStats.emplace(name, TimingStats()).first;
+    }
+    it->second.add(nanos);
+}
+
+void SimulationProfiler::openHardwareCounters() {
+#ifdef __linux__
+    const uint64_t configs[kHardwareCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < kHardwareCounters; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        perfFds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (perfFds[i] >= 0) {
+            ioctl(perfFds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(perfFds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void SimulationProfiler::closeHardwareCounters() {
+#ifdef __linux__
+    for (int i = 0; i < kHardwareCounters; ++i) {
+        if (perfFds[i] < 0) continue;
+        ioctl(perfFds[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(perfFds[i], &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+            hardwareCounts[i] = value;
+        }
+        close(perfFds[i]);
+        perfFds[i] = -1;
+    }
+#endif
+}
+
+void SimulationProfiler::report(std::ostream& out) const {
+    if (!enabled) return;
+    std::ios_base::fmtflags savedFlags = out.flags();
+    std::streamsize savedPrecision = out.precision();
+
+    double runSeconds = (runEndNanos - runStartNanos) / 1e9;
+    out << "=== Simulation profile ===" << std::endl;
+    out << "Events processed: " << eventsProcessed << " in " << std::fixed << std::setprecision(3) << runSeconds << " s ("
+        << std::setprecision(0) << (runSeconds > 0 ? eventsProcessed / runSeconds : 0.0) << " events/sec)" << std::endl;
+    out << "Event queue high-water mark: " << maxQueueDepth << std::endl;
+
+    std::vector<std::pair<std::string, const TimingStats*>> rows;
+    for (const auto& pair : eventStats) {
+        rows.emplace_back(eventTypeName(pair.first), &pair.second);
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second->totalNanos > b.second->totalNanos;
+    });
+    printStatsHeader(out, "event type");
+    for (const auto& row : rows) {
+        printStatsRow(out, row.first, *row.second);
+    }
+
+    if (!sectionStats.empty()) {
+        printStatsHeader(out, "section");
+        for (const auto& pair : sectionStats) {
+            printStatsRow(out, pair.first, pair.second);
+        }
+    }
+
+    if (!throughputSamples.empty()) {
+        out << "Throughput over time (s: events/sec):";
+        for (const auto& sample : throughputSamples) {
+            out << " " << std::setprecision(1) << sample.first << ": " << std::setprecision(0) << sample.second;
+        }
+        out << std::endl;
+    }
+
+    if (hardwareCountersRequested) {
+        bool anyHardwareCounts = std::any_of(hardwareCounts.begin(), hardwareCounts.end(), [](uint64_t value) { return value != 0; });
+        if (anyHardwareCounts) {
+            out << "Hardware counters (user space, whole run):" << std::endl;
+            for (int i = 0; i < kHardwareCounters; ++i) {
+                out << "  " << std::left << std::setw(16) << kHardwareCounterNames[i] << std::right << hardwareCounts[i] << std::endl;
+            }
+        } else {
+            out << "Hardware counters unavailable (perf_event_open failed or unsupported)." << std::endl;
+        }
+    }
+
+    out.flags(savedFlags);
+    out.precision(savedPrecision);
+}
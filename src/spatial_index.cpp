@@ -0,0 +1,45 @@
+#include "spatial_index.h"
+#include <cmath>
+
+SpatialIndex::SpatialIndex(double cellSize) : cellSize(cellSize > 0.0 ? cellSize : 1.0) {}
+
+void SpatialIndex::clear() {
+    cells.clear();
+    objectCount = 0;
+}
+
+void SpatialIndex::insert(ObjectID objectId, Location location) {
+    cells[cellKey(cellCoordinate(location.first), cellCoordinate(location.second))].push_back({objectId, location});
+    ++objectCount;
+}
+
+void SpatialIndex::queryRadius(Location center, double radius, std::vector<ObjectID>& result) const {
+    result.clear();
+    if (radius < 0.0 || cells.empty()) return;
+    int64_t minX = cellCoordinate(center.first - radius);
+    int64_t maxX = cellCoordinate(center.first + radius);
+    int64_t minY = cellCoordinate(center.second - radius);
+    int64_t maxY = cellCoordinate(center.second + radius);
+    double radiusSquared = radius * radius;
+    for (int64_t cellX = minX; cellX <= maxX; ++cellX) {
+        for (int64_t cellY = minY; cellY <= maxY; ++cellY) {
+            auto cell = cells.find(cellKey(cellX, cellY));
+            if (cell == cells.end()) continue;
+            for (const Entry& entry : cell->second) {
+                double dx = entry.location.first - center.first;
+                double dy = entry.location.second - center.second;
+                if (dx * dx + dy * dy <= radiusSquared) {
+                    result.push_back(entry.id);
+                }
+            }
+        }
+    }
+}
+
+int64_t SpatialIndex::cellCoordinate(double value) const {
+    return static_cast<int64_t>(std::floor(value / cellSize));
+}
+
+uint64_t SpatialIndex::cellKey(int64_t cellX, int64_t cellY) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
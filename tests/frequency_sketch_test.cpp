@@ -0,0 +1,35 @@
+#include "frequency_sketch.h"
+#include <iostream>
+
+// Returns the number of failed checks
+static int check(bool condition, const char* description) {
+    if (!condition) {
+        std::cerr << "FAILED: " << description << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    int failures = 0;
+
+    // A saturated counter must still age once sampleSize accesses have been recorded
+    FrequencySketch sketch(16);
+    for (int i = 0; i < sketch.samplePeriod() - 1; ++i) {
+        sketch.increment(1);
+    }
+    failures += check(sketch.estimate(1) == 15, "hot object saturates at 15");
+    sketch.increment(9);
+    failures += check(sketch.estimate(1) == 7, "saturated counter halves after sampleSize accesses");
+
+    // A popularity shift eventually lets a new object overtake a saturated one
+    for (int i = 0; i < 4 * sketch.samplePeriod(); ++i) {
+        sketch.increment(9);
+    }
+    failures += check(sketch.estimate(9) > sketch.estimate(1), "new hot object overtakes the old one");
+
+    if (failures == 0) {
+        std::cout << "frequency_sketch_test: all checks passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}